@@ -60,10 +60,15 @@ SOURCES      := AS_global.C \
                 stores/gkStorePartition.C \
                 \
                 stores/ovOverlap.C \
+                stores/ovOverlapColumns.C \
                 stores/ovStore.C \
                 stores/ovStoreWriter.C \
+                stores/ovStoreMap.C \
                 stores/ovStoreFilter.C \
+                stores/ovStoreSliceWriter.C \
+                stores/ovTextConverter.C \
                 stores/ovStoreFile.C \
+                stores/ovStoreFilePacked.C \
                 stores/ovStoreHistogram.C \
                 \
                 stores/tgStore.C \
@@ -89,6 +94,7 @@ SOURCES      := AS_global.C \
                 overlapInCore/liboverlap/prefixEditDistance-extend.C \
                 overlapInCore/liboverlap/prefixEditDistance-forward.C \
                 overlapInCore/liboverlap/prefixEditDistance-reverse.C \
+                overlapInCore/liboverlap/prefixEditDistance-vector.C \
                 \
                 overlapInCore/libedlib/edlib.C \
                 \
@@ -176,6 +182,7 @@ SUBMAKEFILES := stores/dumpBlob.mk \
                 stores/ovStoreIndexer.mk \
                 stores/ovStoreDump.mk \
                 stores/ovStoreStats.mk \
+                stores/ovStoreSubset.mk \
                 stores/tgStoreCompress.mk \
                 stores/tgStoreDump.mk \
                 stores/tgStoreLoad.mk \
@@ -11,7 +11,10 @@ TARGET   := overlapInCore
 SOURCES  := overlapInCore.C \
             overlapInCore-Build_Hash_Index.C \
             overlapInCore-Find_Overlaps.C \
+            overlapInCore-Hash_File.C \
+            overlapInCore-Minimizers.C \
             overlapInCore-Output.C \
+            overlapInCore-Perf.C \
             overlapInCore-Process_Overlaps.C \
             overlapInCore-Process_String_Overlaps.C
 
@@ -681,10 +681,11 @@ sub setOverlapDefaults ($$$) {
 
     #  OverlapInCore parameters.
 
-    setOverlapDefault($tag, "OvlHashBlockLength",  undef,                     "Amount of sequence (bp) to load into the overlap hash table");
+    setOverlapDefault($tag, "OvlHashBlockLength",  undef,                     "Amount of sequence (bp) to load into the overlap hash table; default: as much as fits in ${tag}OvlMemory and the hash table");
     setOverlapDefault($tag, "OvlRefBlockSize",     undef,                     "Number of reads to search against the hash table per batch");
     setOverlapDefault($tag, "OvlRefBlockLength",   0,                         "Amount of sequence (bp) to search against the hash table per batch");
-    setOverlapDefault($tag, "OvlHashBits",         ($tag eq "cor") ? 18 : 23, "Width of the kmer hash.  Width 22=1gb, 23=2gb, 24=4gb, 25=8gb.  Plus 10b per ${tag}OvlHashBlockLength");
+    setOverlapDefault($tag, "OvlBalance",          0,                         "Split jobs to about equal predicted run time, using a ${tag}OvlRefBlockSize or ${tag}OvlRefBlockLength job as the target; default 'false'");
+    setOverlapDefault($tag, "OvlHashBits",         ($tag eq "cor") ? 18 : 23, "Width of the kmer hash.  Width 22=1gb, 23=2gb, 24=4gb, 25=8gb.  Plus 1b and two packed references (usually 4b each) per base of ${tag}OvlHashBlockLength.  At the default load, the table holds at most 14 * 2^width bases");
     setOverlapDefault($tag, "OvlHashLoad",         0.75,                      "Maximum hash table load.  If set too high, table lookups are inefficent; if too low, search overhead dominates run time; default 0.75");
     setOverlapDefault($tag, "OvlMerSize",          ($tag eq "cor") ? 19 : 22, "K-mer size for seeds in overlaps");
     setOverlapDefault($tag, "OvlMerThreshold",     "auto",                    "K-mer frequency threshold; mers more frequent than this count are ignored; default 'auto'");
@@ -869,6 +870,7 @@ sub setDefaults () {
     ##### Overlap Store
 
     setDefault("ovsMethod", undef, "Use the 'sequential' or 'parallel' algorithm for constructing an overlap store; default 'sequential'");
+    setDefault("ovsPacked", 0,     "Write the overlap store in the packed format; smaller, but not readable by older tools; default 'false'");
 
     #####  Mers
 
@@ -656,6 +656,8 @@ sub submitScript ($$) {
     if (getGlobal("ovsMethod") eq "sequential") {
         $mem = getGlobal("ovsMemory");
         $mem = $2  if ($mem =~ m/^(\d+)-(\d+)$/);
+        $thr = getGlobal("ovsThreads");
+        $thr = $2  if ($thr =~ m/^(\d+)-(\d+)$/);
     }
 
     $memOption = buildMemoryOption($mem, 1);
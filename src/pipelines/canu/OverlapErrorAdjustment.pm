@@ -654,6 +654,7 @@ sub updateOverlapStore ($) {
     $cmd .= "  -G ../$asm.gkpStore \\\n";
     $cmd .= "  -O ../$asm.ovlStore \\\n";
     $cmd .= "  -evalues \\\n";
+    $cmd .= "  -t 1 \\\n";                  #  Runs in the canu process, which reserves one thread.
     $cmd .= "  -L ./oea.files \\\n";
     $cmd .= "> ./oea.apply.err 2>&1";
 
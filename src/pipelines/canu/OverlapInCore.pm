@@ -111,24 +111,51 @@ sub overlapConfigure ($$$) {
 
         my $hashBlockLength = getGlobal("${tag}OvlHashBlockLength");
         my $hashBlockSize   = 0;
+        my $hashBits        = getGlobal("${tag}OvlHashBits");
+        my $hashLoad        = getGlobal("${tag}OvlHashLoad");
         my $refBlockSize    = getGlobal("${tag}OvlRefBlockSize");
         my $refBlockLength  = getGlobal("${tag}OvlRefBlockLength");
         my $minOlapLength   = getGlobal("minOverlapLength");
+        my $merSize         = getGlobal("${tag}OvlMerSize");
+        my $merFile         = "$base/0-mercounts/$asm.ms$merSize";
+        my $merMax          = undef;
 
         if (($refBlockSize > 0) && ($refBlockLength > 0)) {
             caExit("can't set both ${tag}OvlRefBlockSize and ${tag}OvlRefBlockLength", undef);
         }
 
+        #  The cost model (and balancing) uses the kmer histogram, ignoring kmers frequent enough
+        #  to be in the frequent mers list, which has everything at or above the threshold.
+
+        fetchFile("$merFile.histogram");
+        fetchFile("$merFile.frequentMers.fasta");
+
+        if (-e "$merFile.frequentMers.fasta") {
+            open(F, "< $merFile.frequentMers.fasta") or caExit("can't open '$merFile.frequentMers.fasta' for reading: $!", undef);
+            while (<F>) {
+                $merMax = $1 - 1   if ((m/^>(\d+)/) && ((!defined($merMax)) || ($1 - 1 < $merMax)));
+            }
+            close(F);
+        }
+
         $cmd  = "$bin/overlapInCorePartition \\\n";
         $cmd .= " -g  ../$asm.gkpStore \\\n";
-        $cmd .= " -bl $hashBlockLength \\\n";
+        $cmd .= " -bl $hashBlockLength \\\n"  if (defined($hashBlockLength));
         $cmd .= " -bs $hashBlockSize \\\n";
+        $cmd .= " -M  " . getGlobal("${tag}OvlMemory") . " \\\n";
+        $cmd .= " -t  " . getGlobal("${tag}OvlThreads") . " \\\n";
+        $cmd .= " -hb $hashBits \\\n";
+        $cmd .= " -hl $hashLoad \\\n";
         $cmd .= " -rs $refBlockSize \\\n";
         $cmd .= " -rl $refBlockLength \\\n";
         #$cmd .= " -H $hashLibrary \\\n" if ($hashLibrary ne "0");
         #$cmd .= " -R $refLibrary \\\n"  if ($refLibrary ne "0");
         #$cmd .= " -C \\\n" if (!$checkLibrary);
         $cmd .= " -ol $minOlapLength \\\n";
+        $cmd .= " -k  $merSize \\\n";
+        $cmd .= " -mh ../0-mercounts/$asm.ms$merSize.histogram \\\n"   if (-e "$merFile.histogram");
+        $cmd .= " -mm $merMax \\\n"                                     if (defined($merMax));
+        $cmd .= " -balance \\\n"                                        if (getGlobal("${tag}OvlBalance"));
         $cmd .= " -o  ./$asm.partition \\\n";
         $cmd .= "> ./$asm.partition.err 2>&1";
 
@@ -216,6 +243,7 @@ sub overlapConfigure ($$$) {
         print F "  \$opt \\\n";
         print F "  -o ./\$job.ovb.WORKING \\\n";
         print F "  -s ./\$job.stats \\\n";
+        print F "  --perf ./\$job.perf \\\n";
         #print F "  -H $hashLibrary \\\n" if ($hashLibrary ne "0");
         #print F "  -R $refLibrary \\\n"  if ($refLibrary  ne "0");
         print F "  ../$asm.gkpStore \\\n";
@@ -225,6 +253,7 @@ sub overlapConfigure ($$$) {
         print F stashFileShellCode("$base/1-overlapper/", "\$job.ovb", "");
         print F stashFileShellCode("$base/1-overlapper/", "\$job.counts", "");
         print F stashFileShellCode("$base/1-overlapper/", "\$job.stats", "");
+        print F stashFileShellCode("$base/1-overlapper/", "\$job.perf", "");
         print F "\n";
         print F "exit 0\n";
         close(F);
@@ -382,6 +382,7 @@ sub mmapConfigure ($$$) {
     print F "     ! -e ./results/\$qry.ovb ] ; then\n";
     print F "  \$bin/mmapConvert \\\n";
     print F "    -G ../$asm.gkpStore \\\n";
+    print F "    -t " . getGlobal("${tag}mmapThreads") . " \\\n";
     print F "    -o ./results/\$qry.mmap.ovb.WORKING \\\n";
     print F "    -partial \\\n"  if ($typ eq "partial");
     print F "    -tolerance 100 \\\n" if ($typ eq "normal");
@@ -493,6 +493,7 @@ sub mhapConfigure ($$$) {
     print F "     ! -e ./results/\$qry.ovb ] ; then\n";
     print F "  \$bin/mhapConvert \\\n";
     print F "    -G ../$asm.gkpStore \\\n";
+    print F "    -t " . getGlobal("${tag}mhapThreads") . " \\\n";
     print F "    -o ./results/\$qry.mhap.ovb.WORKING \\\n";
     print F "    ./results/\$qry.mhap \\\n";
     print F "  && \\\n";
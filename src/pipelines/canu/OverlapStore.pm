@@ -93,11 +93,17 @@ sub createOverlapStoreSequential ($$$) {
 
     #  The parallel store build will unlimit 'max user processes'.  The sequential method usually
     #  runs out of open file handles first (meaning it has never run out of processes yet).
+    #
+    #  The sequential build merges sorted runs; if all overlaps fit in memory, nothing but the
+    #  store is written.  With ovsPacked, store files are packed, about 60% the size of plain ones.
 
     $cmd  = "$bin/ovStoreBuild \\\n";
     $cmd .= " -O ./$asm.ovlStore.BUILDING \\\n";
     $cmd .= " -G ./$asm.gkpStore \\\n";
     $cmd .= " -M $memSize \\\n";
+    $cmd .= " -t " . getGlobal("ovsThreads") . " \\\n";
+    $cmd .= " -merge \\\n";
+    $cmd .= " -packed \\\n"  if (getGlobal("ovsPacked"));
     $cmd .= " -L ./1-overlapper/ovljob.files \\\n";
     $cmd .= " > ./$asm.ovlStore.err 2>&1";
 
@@ -290,6 +296,7 @@ sub overlapStoreConfigure ($$$) {
         print F "  -O . \\\n";
         print F "  -G ../$asm.gkpStore \\\n";
         print F "  -C ./config \\\n";
+        print F "  -t " . getGlobal("ovbThreads") . " \\\n";
         #print F "  -e " . getGlobal("") . " \\\n"  if (defined(getGlobal("")));
         print F "  -job \$jobid \\\n";
         print F "  -i   \$jn\n";
@@ -313,9 +320,11 @@ sub overlapStoreConfigure ($$$) {
         print F "\$bin/ovStoreSorter \\\n";
         print F "  -deletelate \\\n";  #  Choices -deleteearly -deletelate or nothing
         print F "  -M $memLimit \\\n";
+        print F "  -t " . getGlobal("ovsThreads") . " \\\n";
         print F "  -O . \\\n";
         print F "  -G ../$asm.gkpStore \\\n";
         print F "  -F $numSlices \\\n";
+        print F "  -packed \\\n"  if (getGlobal("ovsPacked"));
         print F "  -job \$jobid $numInputs\n";
         close(F);
     }
@@ -695,11 +704,15 @@ sub createOverlapStore ($$$) {
         my $bin   = getBinDirectory();
         my $cmd;
 
+        #  This runs in the canu process, which has only one thread reserved (unless ovsMethod is
+        #  sequential), and each thread keeps its own copy of the histograms.
+
         $cmd  = "$bin/ovStoreStats \\\n";
         $cmd .= " -G ./$asm.gkpStore \\\n";
         $cmd .= " -O ./$asm.ovlStore \\\n";
         $cmd .= " -C " . getExpectedCoverage("utg", $asm). " \\\n";
         $cmd .= " -o ./$asm.ovlStore \\\n";
+        $cmd .= " -t 1 \\\n";
         $cmd .= " > ./$asm.ovlStore.summary.err 2>&1";
 
         if (runCommand($base, $cmd)) {